@@ -41,6 +41,11 @@
 #include <algorithm>
 #include <functional>
 #include <cctype>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <vector>
 
 ///
 /// Utility class for loading environment variables from a file.
@@ -103,7 +108,27 @@ public:
 
     static std::string getenv(const char* name, const std::string& def = "");
 
+    static void set_override(const char* name, const std::string& value);
+    static void set_overrides(const std::map<std::string, std::string>& batch);
+    static void clear_overrides();
+
 private:
+    typedef std::map<std::string, std::string> overrides_t;
+
+    struct overrides_slot
+    {
+        overrides_slot() : delta(nullptr) {}
+
+        std::atomic<const overrides_t*> delta;  // published map, or nullptr
+        std::mutex write_lock;                  // serializes writers
+        std::vector<std::unique_ptr<const overrides_t>> maps;  // every map published so far
+    };
+
+    static overrides_slot& overrides();
+    static const overrides_t* load_overrides();
+    static void store_overrides(std::unique_ptr<const overrides_t> delta);
+    static bool lookup(const std::string& name, std::string& value);
+
     static void do_init(int flags, const char* filename);
     static std::string strip_quotes(const std::string& str);
 
@@ -148,19 +173,130 @@ inline void dotenv::init(int flags, const char* filename)
 }
 
 ///
-/// Wrapper for std::getenv() which also takes a default value, in case the
-/// variable turns out to be empty.
+/// Look up a variable among the runtime overrides and then in the environment,
+/// taking a default value in case the variable turns out to be empty.
 ///
 /// \param name the name of the variable to look up
 /// \param def  a default value
 ///
-/// \returns the value of the environment variable \a name, or \a def if the
-///          variable is not set
+/// \returns the runtime override for \a name if one is set (see
+///          set_overrides()), otherwise the value of the environment variable
+///          \a name, or \a def if the variable is not set
 ///
 inline std::string dotenv::getenv(const char* name, const std::string& def)
 {
-    const char* str = std::getenv(name);
-    return str ? std::string(str) : def;
+    std::string value;
+    return lookup(name, value) ? value : def;
+}
+
+///
+/// Override a single variable at runtime, without touching the process
+/// environment. See set_overrides().
+///
+/// \param name  the name of the variable to override
+/// \param value the new value
+///
+inline void dotenv::set_override(const char* name, const std::string& value)
+{
+    overrides_t batch;
+    batch[name] = value;
+    dotenv::set_overrides(batch);
+}
+
+///
+/// Override a batch of variables at runtime.
+///
+/// Unlike `setenv()`, this is safe to call while other threads are reading
+/// variables through `dotenv::getenv()`. The overrides are kept in a small
+/// immutable map which is copied, updated and then published through a single
+/// atomic pointer, so readers either see all of \a batch or none of it.
+/// Readers never lock; they pay one atomic load plus, once any override has
+/// been set, a map lookup. Writers are serialized by a mutex.
+///
+/// Since readers may still be using an older map, every map published is kept
+/// until the program exits, so overrides are meant for infrequent updates such
+/// as those made by an operator.
+///
+/// Overrides take precedence over the environment, and are also used to expand
+/// `$VARIABLE` and `${VARIABLE}` references if `dotenv::init()` is called
+/// again. They are not visible through `std::getenv()`. Note that
+/// `dotenv::init()` itself still writes to the environment with `setenv()`,
+/// so it must only be called before any threads reading variables are
+/// started.
+///
+/// \param batch the names and values to override
+///
+inline void dotenv::set_overrides(const std::map<std::string, std::string>& batch)
+{
+    std::lock_guard<std::mutex> guard(overrides().write_lock);
+
+    const overrides_t* current = load_overrides();
+    std::unique_ptr<overrides_t> merged(current ? new overrides_t(*current) : new overrides_t);
+    for (const auto& kv : batch)
+        (*merged)[kv.first] = kv.second;
+
+    store_overrides(std::move(merged));
+}
+
+///
+/// Remove all runtime overrides, so that `dotenv::getenv()` once again reads
+/// from the environment only.
+///
+inline void dotenv::clear_overrides()
+{
+    std::lock_guard<std::mutex> guard(overrides().write_lock);
+    store_overrides(nullptr);
+}
+
+// the currently published set of runtime overrides
+inline dotenv::overrides_slot& dotenv::overrides()
+{
+    static overrides_slot slot;
+    return slot;
+}
+
+// the current overrides, or nullptr if none are set; the map stays valid
+// after a later swap
+inline const dotenv::overrides_t* dotenv::load_overrides()
+{
+    return overrides().delta.load(std::memory_order_acquire);
+}
+
+// publish a new set of overrides (callers must hold write_lock)
+inline void dotenv::store_overrides(std::unique_ptr<const overrides_t> delta)
+{
+    auto& slot = overrides();
+    const overrides_t* ptr = delta.get();
+    if (delta)
+        slot.maps.push_back(std::move(delta));
+    slot.delta.store(ptr, std::memory_order_release);
+}
+
+///
+/// Look up a variable, first among the runtime overrides and then in the
+/// environment.
+///
+/// \param name  the name of the variable to look up
+/// \param value out: the value of the variable, if found
+///
+/// \returns true if the variable is set
+///
+inline bool dotenv::lookup(const std::string& name, std::string& value)
+{
+    if (const overrides_t* delta = load_overrides())
+    {
+        const auto it = delta->find(name);
+        if (it != delta->end())
+        {
+            value = it->second;
+            return true;
+        }
+    }
+
+    const char* str = std::getenv(name.c_str());
+    if (str)
+        value = str;
+    return str != nullptr;
 }
 
 #ifdef _MSC_VER
@@ -291,8 +427,9 @@ inline std::pair<std::string, bool> dotenv::resolve_vars(size_t iline, const std
             // remove possible whitespace at the end
             rtrim(env_var);
 
-            // evaluate environment variable
-            if(const char* env_str = std::getenv(env_var.c_str()))
+            // evaluate variable, preferring runtime overrides
+            std::string env_str;
+            if(lookup(env_var, env_str))
             {
                resolved += env_str;
                nvar--; // decrement to indicate variable resolved